@@ -50,7 +50,7 @@
     
     Copies from a memory location to your "hands." Generates an immediate error if the memory location specified is invalid for the room, or is empty.
 
-    COPYTO: copies from your "hands" to a memory location. Generates an immediate error if your hands are empty.
+    COPYTO: copies from your "hands" to a memory location; the value stays in your hands. Generates an immediate error if your hands are empty.
 
     In the visual version of the game, it is impossible to specify an invalid memory address, because you write the program by choosing a space on the
     room floor. However, a text representation of the program could specify an invalid memory address, so we should check these against the room
@@ -78,7 +78,7 @@
     instruction. Works on either numbers or characters.
 
     JUMP_IF_NEGATIVE: similar to jump if zero, except it checks for a negative value in your "hands." I'm not sure what happens if you try to
-    JUMP_IF_NEGATIVE on a character value.
+    JUMP_IF_NEGATIVE on a character value. For now both conditional jumps treat a character as neither zero nor negative and fall through.
 
     BUMP_PLUS: increments the value in a memory location. Exceeding 999 generates an immediate error. Copies the incremented value into your "hands."
     I'm not sure if you can bump up a character. Maybe you can bump up a character as long as the result doesn't exceed the range A..Z.
@@ -108,6 +108,9 @@ typedef enum HRMValueType_e
 
 typedef int16_t hrm_num;
 
+#define HRM_NUM_MIN ( -999 )
+#define HRM_NUM_MAX ( 999 )
+
 typedef uint8_t hrm_char;
 
 typedef union HRMVal_u
@@ -130,14 +133,14 @@ typedef struct HRMVal_s
 static HRMVal_t floor_a[NUM_FLOOR_VALUES];
 
 /* Sample input data from the game */
-static HRMVal_t in_fifo[NUM_INBOX_VALUES] = { { NUM, .val.n =  7  },
-                                              { NUM, .val.n =  0  },
-                                              { NUM, .val.n =  5  },
-                                              { NUM, .val.c = 'D' },
-                                              { NUM, .val.n =  0  },
-                                              { NUM, .val.n =  0  },
-                                              { NUM, .val.n =  0  },
-                                              { NUM, .val.n =  0  } };
+static HRMVal_t in_fifo[NUM_INBOX_VALUES] = { { NUM,  .val.n =  7  },
+                                              { NUM,  .val.n =  0  },
+                                              { NUM,  .val.n =  5  },
+                                              { CHAR, .val.c = 'D' },
+                                              { NUM,  .val.n =  0  },
+                                              { NUM,  .val.n =  0  },
+                                              { NUM,  .val.n =  0  },
+                                              { NUM,  .val.n =  0  } };
 
 /*
     For now, assume the out FIFO won't have more values than the in, although this is not true for all the programs we want to implement
@@ -191,14 +194,39 @@ typedef enum HRMErr_e
     ERR_BAD_TYPE_FOR_BUMP_IN_MEMORY,
     ERR_OVERFLOW,
     ERR_UNDERFLOW,
+    ERR_OUTBOX_FULL,
+    ERR_INSTRUCTION_LIMIT_EXCEEDED,
+    ERR_VERIFY_COUNTEREXAMPLE,
+    ERR_VERIFY_ROOM_MEMORY_TOO_LARGE,
+    ERR_VERIFY_ROOM_INBOX_TOO_LARGE,
+    ERR_VERIFY_ROOM_BAD_NUM_RANGE,
+    ERR_VERIFY_ORACLE_OUTBOX_TOO_SMALL,
+    ERR_VERIFY_MISSED_COUNTEREXAMPLE,
+    ERR_VERIFY_COUNTEREXAMPLE_NOT_SHRUNK,
+    ERR_VERIFY_BAD_STEP_COUNTS,
     
 } HRMErr_t;
 
+/*
+    The input and output queues for a single run of a program. The inbox is read-only; the outbox is filled in by the run, which also reports
+    how many instructions it executed (the "steps" count used for scoring in the game).
+*/
+typedef struct HRMRun_s
+{
+    HRMVal_t const * inbox;
+    uint8_t inbox_len;
+    HRMVal_t * outbox;
+    uint8_t outbox_cap;
+    uint8_t outbox_len;
+    uint16_t steps;
+
+} HRMRun_t;
+
 /*
     Note that in the game, program addresses are 1-based, so we encode them that way.
 */
 #define ROOM_MEMORY_SIZE_ZERO_PRESERVATION_INITIATIVE ( 9 )
-static HRMVal_t mem_zero_preservation_initiative[ROOM_MEMORY_SIZE_ZERO_PRESERVATION_INITIATIVE] = { 0 };
+static HRMVal_t const mem_zero_preservation_initiative[ROOM_MEMORY_SIZE_ZERO_PRESERVATION_INITIATIVE] = { 0 };
 static const HRMInstruction_t pgm_zero_preservation_initiative[] = {
                                                                      { INBOX                                  }, /* 1 */
                                                                      { JUMP_ZERO, { PROG_ADDR,   { .n = 4 } } }, /* 2 */
@@ -207,6 +235,41 @@ static const HRMInstruction_t pgm_zero_preservation_initiative[] = {
                                                                      { JUMP,      { PROG_ADDR,   { .n = 1 } } }, /* 5 */
                                                                  };
 
+/*
+    The same room solved by way of the floor, to exercise the memory instructions.
+*/
+static const HRMInstruction_t pgm_zero_preservation_initiative_via_floor[] = {
+                                                                               { INBOX                                  }, /* 1 */
+                                                                               { COPYTO,    { NUM,         { .n = 0 } } }, /* 2 */
+                                                                               { COPYFROM,  { NUM,         { .n = 0 } } }, /* 3 */
+                                                                               { JUMP_ZERO, { PROG_ADDR,   { .n = 6 } } }, /* 4 */
+                                                                               { JUMP,      { PROG_ADDR,   { .n = 1 } } }, /* 5 */
+                                                                               { OUTBOX                                 }, /* 6 */
+                                                                               { JUMP,      { PROG_ADDR,   { .n = 1 } } }, /* 7 */
+                                                                           };
+
+/*
+    A wrong solution which sends everything to the outbox. The verifier should reject it.
+*/
+static const HRMInstruction_t pgm_zero_preservation_initiative_broken[] = {
+                                                                            { INBOX                                  }, /* 1 */
+                                                                            { OUTBOX                                 }, /* 2 */
+                                                                            { JUMP,      { PROG_ADDR,   { .n = 1 } } }, /* 3 */
+                                                                        };
+
+#define ROOM_MEMORY_SIZE_TRIPLER_ROOM ( 3 )
+static HRMVal_t const mem_tripler_room[ROOM_MEMORY_SIZE_TRIPLER_ROOM] = { 0 };
+static const HRMInstruction_t pgm_tripler_room[] = {
+                                                     { INBOX                                  }, /* 1 */
+                                                     { COPYTO,    { NUM,         { .n = 0 } } }, /* 2 */
+                                                     { ADD,       { NUM,         { .n = 0 } } }, /* 3 */
+                                                     { ADD,       { NUM,         { .n = 0 } } }, /* 4 */
+                                                     { OUTBOX                                 }, /* 5 */
+                                                     { JUMP,      { PROG_ADDR,   { .n = 1 } } }, /* 6 */
+                                                 };
+
+#define PGM_LEN( pgm ) ( ( uint8_t )( sizeof( pgm ) / sizeof( HRMInstruction_t ) ) )
+
 #define MAX_INSTRUCTIONS_ALLOWED ( 1000 )
 
 static HRMVal_t hands = { EMPTY, {} };
@@ -248,7 +311,7 @@ static HRMErr_t verify_direct_addr( HRMVal_t direct_addr, HRMVal_t * const mem,
     {
         ret_val = ERR_INVALID_TYPE_FOR_DIRECT_ADDR;
     }
-    else if ( direct_addr.val.n >= ( uint16_t )mem_len )
+    else if ( ( direct_addr.val.n < 0 ) || ( direct_addr.val.n >= ( int16_t )mem_len ) )
     {
         ret_val = ERR_DIRECT_ADDR_OUT_OF_RANGE;
     }
@@ -265,7 +328,7 @@ static HRMErr_t verify_indirect_addr( HRMVal_t indirect_addr, HRMVal_t * const m
     {
         ret_val = ERR_INVALID_TYPE_FOR_INDIRECT_ADDR;
     }
-    else if ( indirect_addr.val.n >= ( uint16_t )mem_len )
+    else if ( ( indirect_addr.val.n < 0 ) || ( indirect_addr.val.n >= ( int16_t )mem_len ) )
     {
         ret_val = ERR_INDIRECT_ADDR_OUT_OF_RANGE;
     }
@@ -279,7 +342,8 @@ static HRMErr_t verify_indirect_addr( HRMVal_t indirect_addr, HRMVal_t * const m
 }
 
 
-static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_len, HRMVal_t * const mem, uint8_t const mem_len )
+static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_len, HRMVal_t * const mem, uint8_t const mem_len,
+                         HRMRun_t * const run )
 {
     uint16_t pgm_num_instructions_executed = 0;
     uint16_t pgm_pc = 0;
@@ -292,6 +356,9 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
     HRMErr_t err = ERR_NONE;
     HRMVal_t value;
 
+    /* Every run starts with empty hands; the verifier executes many runs back to back */
+    hands.type = EMPTY;
+
     /* Our "virtual machine" */
     while ( ( 0 == inbox_empty )          &&
             ( ERR_NONE == err )           &&
@@ -301,13 +368,13 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
         switch ( pgm[pgm_pc].inst )
         {
             case INBOX:
-                if ( in_fifo_val_idx >= NUM_INBOX_VALUES )
+                if ( in_fifo_val_idx >= run->inbox_len )
                 {
                     inbox_empty = 1;
                 }
                 else
                 {
-                    hands = in_fifo[in_fifo_val_idx];
+                    hands = run->inbox[in_fifo_val_idx];
                     in_fifo_val_idx += 1;
                     pgm_pc += 1;
                 }
@@ -319,9 +386,13 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
                 {
                     err = ERR_EMPTY_HANDS;
                 }
+                else if ( out_fifo_num_vals >= run->outbox_cap )
+                {
+                    err = ERR_OUTBOX_FULL;
+                }
                 else
                 {
-                    out_fifo[out_fifo_num_vals] = hands;
+                    run->outbox[out_fifo_num_vals] = hands;
                     out_fifo_num_vals += 1;
                     pgm_pc += 1;
                 }
@@ -342,6 +413,8 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
                         hands = value;
                     }
                 }
+                pgm_pc += 1;
+                pgm_num_instructions_executed += 1;
                 break;
 
             case COPYFROM_IND:
@@ -358,24 +431,36 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
                         hands = value;
                     }
                 }
+                pgm_pc += 1;
+                pgm_num_instructions_executed += 1;
                 break;
 
             case COPYTO:
-                err = verify_direct_addr( pgm[pgm_pc].param, mem, mem_len );
+                err = verify_hands_not_empty();
+                if ( ERR_NONE == err )
+                {
+                    err = verify_direct_addr( pgm[pgm_pc].param, mem, mem_len );
+                }
                 if ( ERR_NONE == err )
                 {
                     mem[pgm[pgm_pc].param.val.n] = hands;
-                    hands.type = EMPTY;
                 }
+                pgm_pc += 1;
+                pgm_num_instructions_executed += 1;
                 break;
 
             case COPYTO_IND:
-                err = verify_indirect_addr( pgm[pgm_pc].param, mem, mem_len );
+                err = verify_hands_not_empty();
+                if ( ERR_NONE == err )
+                {
+                    err = verify_indirect_addr( pgm[pgm_pc].param, mem, mem_len );
+                }
                 if ( ERR_NONE == err )
                 {
                     mem[mem[pgm[pgm_pc].param.val.n].val.n] = hands;
-                    hands.type = EMPTY;
                 }
+                pgm_pc += 1;
+                pgm_num_instructions_executed += 1;
                 break;
 
             case ADD:
@@ -396,17 +481,19 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
                         else
                         {
                             hands.val.n += value.val.n;
-                            if ( hands.val.n < 999 )
+                            if ( hands.val.n < HRM_NUM_MIN )
                             {
                                 err = ERR_UNDERFLOW;
                             }
-                            else if ( hands.val.n > 999 )
+                            else if ( hands.val.n > HRM_NUM_MAX )
                             {
                                 err = ERR_OVERFLOW;
                             }
                         }
                     }
                 }
+                pgm_pc += 1;
+                pgm_num_instructions_executed += 1;
                 break;
 
             case ADD_IND:
@@ -427,17 +514,19 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
                         else
                         {
                             hands.val.n += value.val.n;
-                            if ( hands.val.n < 999 )
+                            if ( hands.val.n < HRM_NUM_MIN )
                             {
                                 err = ERR_UNDERFLOW;
                             }
-                            else if ( hands.val.n > 999 )
+                            else if ( hands.val.n > HRM_NUM_MAX )
                             {
                                 err = ERR_OVERFLOW;
                             }
                         }
                     }
                 }
+                pgm_pc += 1;
+                pgm_num_instructions_executed += 1;
                 break;
 
             case SUB:
@@ -458,17 +547,19 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
                         else
                         {
                             hands.val.n -= value.val.n;
-                            if ( hands.val.n < 999 )
+                            if ( hands.val.n < HRM_NUM_MIN )
                             {
                                 err = ERR_UNDERFLOW;
                             }
-                            else if ( hands.val.n > 999 )
+                            else if ( hands.val.n > HRM_NUM_MAX )
                             {
                                 err = ERR_OVERFLOW;
                             }
                         }
                     }
                 }
+                pgm_pc += 1;
+                pgm_num_instructions_executed += 1;
                 break;
 
             case SUB_IND:
@@ -489,17 +580,19 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
                         else
                         {
                             hands.val.n -= value.val.n;
-                            if ( hands.val.n < 999 )
+                            if ( hands.val.n < HRM_NUM_MIN )
                             {
                                 err = ERR_UNDERFLOW;
                             }
-                            else if ( hands.val.n > 999 )
+                            else if ( hands.val.n > HRM_NUM_MAX )
                             {
                                 err = ERR_OVERFLOW;
                             }
                         }
                     }
                 }
+                pgm_pc += 1;
+                pgm_num_instructions_executed += 1;
                 break;
 
             case BUMP_PLUS:
@@ -514,7 +607,7 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
                     else
                     {
                         value.val.n += 1;
-                        if ( value.val.n > 999 )
+                        if ( value.val.n > HRM_NUM_MAX )
                         {
                             err = ERR_OVERFLOW;
                         }
@@ -525,6 +618,8 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
                         }
                     }
                 }
+                pgm_pc += 1;
+                pgm_num_instructions_executed += 1;
                 break;
 
             case BUMP_PLUS_IND:
@@ -539,7 +634,7 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
                     else
                     {
                         value.val.n += 1;
-                        if ( value.val.n > 999 )
+                        if ( value.val.n > HRM_NUM_MAX )
                         {
                             err = ERR_OVERFLOW;
                         }
@@ -550,6 +645,8 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
                         }
                     }
                 }
+                pgm_pc += 1;
+                pgm_num_instructions_executed += 1;
                 break;
 
             case BUMP_MINUS:
@@ -564,7 +661,7 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
                     else
                     {
                         value.val.n -= 1;
-                        if ( value.val.n < 999 )
+                        if ( value.val.n < HRM_NUM_MIN )
                         {
                             err = ERR_UNDERFLOW;
                         }
@@ -575,6 +672,8 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
                         }
                     }
                 }
+                pgm_pc += 1;
+                pgm_num_instructions_executed += 1;
                 break;
 
             case BUMP_MINUS_IND:
@@ -589,7 +688,7 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
                     else
                     {
                         value.val.n -= 1;
-                        if ( value.val.n < 999 )
+                        if ( value.val.n < HRM_NUM_MIN )
                         {
                             err = ERR_UNDERFLOW;
                         }
@@ -600,6 +699,8 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
                         }
                     }
                 }
+                pgm_pc += 1;
+                pgm_num_instructions_executed += 1;
                 break;
 
             case JUMP:
@@ -608,11 +709,11 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
                 break;
 
             case JUMP_ZERO:
-                if ( NUM != hands.type )
+                if ( EMPTY == hands.type )
                 {
-                    err = 1;
+                    err = ERR_EMPTY_HANDS;
                 }
-                else if ( 0 == hands.val.n )
+                else if ( ( NUM == hands.type ) && ( 0 == hands.val.n ) )
                 {
                     pgm_pc = pgm[pgm_pc].param.val.n - 1; /* Convert to zero-based */
                 }
@@ -624,11 +725,11 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
                 break;
 
             case JUMP_NEGATIVE:
-                if ( NUM != hands.type )
+                if ( EMPTY == hands.type )
                 {
-                    err = 1;
+                    err = ERR_EMPTY_HANDS;
                 }
-                else if ( hands.val.n < 0 )
+                else if ( ( NUM == hands.type ) && ( hands.val.n < 0 ) )
                 {
                     pgm_pc = pgm[pgm_pc].param.val.n - 1; /* Convert to zero-based */
                 }
@@ -647,14 +748,735 @@ static HRMErr_t execute( HRMInstruction_t const * const pgm, uint8_t const pgm_l
 
     }
 
+    if ( ( ERR_NONE == err ) && ( pgm_num_instructions_executed > MAX_INSTRUCTIONS_ALLOWED ) )
+    {
+        err = ERR_INSTRUCTION_LIMIT_EXCEEDED;
+    }
+
+    run->outbox_len = out_fifo_num_vals;
+    run->steps = pgm_num_instructions_executed;
+
+    return err;
+
+}
+
+/*
+    Verifying a solution
+
+    Running a program against the single sample inbox from the game proves very little. The verifier runs a program against a reference
+    oracle over a large set of inboxes and compares the outbox (and any error) from each run. The oracle is either a C function which computes
+    the expected outbox directly, or a trusted HRM program which is executed on the same virtual machine.
+
+    The inboxes are drawn from the values the room allows (numbers in the room's range within -999..999, and/or characters A..Z) in four phases:
+
+    - the empty inbox;
+    - every single-value inbox (exhaustive over the whole domain);
+    - every two- and three-value inbox made from "adversarial" boundary values such as -999, -1, 0, 1, 999, 'A' and 'Z';
+    - pseudo-randomly generated inboxes with boundary values mixed in; half are of the room's full inbox size, the rest cycle through every
+      shorter length.
+
+    Verification stops at the first counterexample. The failing inbox is then shrunk by removing values and moving numbers towards zero, as
+    long as it still fails, so the reported inbox is a minimal one.
+
+    Step counts only come from runs which finish without an error; a run which crashes, even if the oracle expected it to, isn't a solution
+    the game would score. The worst case is taken over all such runs. The average is taken only over inboxes of the room's full inbox size,
+    since that is the size the game scores on; the short inboxes of the earlier phases would drag it down.
+
+    This target has a single core, so the phases run sequentially; the early exit on the first counterexample is what keeps a failing
+    verification cheap.
+
+    The verifier's buffers are sized independently of the 8-value sample inbox above, but they are still fixed: the inbox, outbox and room
+    floor are limited to the VERIFY_MAX_ sizes below. On the AVR those buffers and one HRMVerifyResult_t take about 880 bytes of RAM, plus a
+    128-byte buffer on the stack while a counterexample is shrunk. avr-gcc keeps const data in RAM as well, so with the rooms, programs and
+    sample data the whole program needs about 1.4K of the 2K available. verify() rejects a room which doesn't fit
+    rather than silently truncating it, and stops with ERR_VERIFY_ORACLE_OUTBOX_TOO_SMALL if an oracle needs more outbox than
+    VERIFY_MAX_OUTBOX_LEN; neither is held against the program under test.
+*/
+#define VERIFY_MAX_MEMORY_SIZE ( 25 )
+#define VERIFY_MAX_INBOX_LEN ( 32 )
+#define VERIFY_MAX_OUTBOX_LEN ( 64 )
+#define VERIFY_NUM_RANDOM_INBOXES ( 1000 )
+#define VERIFY_MAX_ADVERSARIAL_LEN ( 3 )
+
+#define HRM_CHAR_DOMAIN_SIZE ( 'Z' - 'A' + 1 )
+
+/*
+    Describes what a room looks like to a program: the initial contents of the room floor, how many values the inbox holds, and which types
+    of value can appear in the inbox. Numbers are limited to num_min..num_max, which must lie within -999..999.
+*/
+typedef struct HRMRoom_s
+{
+    HRMVal_t const * mem_init;
+    uint8_t mem_len;
+    uint8_t max_inbox_len;
+    uint8_t allow_nums;
+    hrm_num num_min;
+    hrm_num num_max;
+    uint8_t allow_chars;
+
+} HRMRoom_t;
+
+/*
+    A C oracle fills in the expected outbox for the given inbox and sets *outbox_len to the number of values it wrote. It returns the error
+    the program is expected to stop with, or ERR_OUTBOX_FULL if the expected outbox doesn't fit in outbox_cap values.
+*/
+typedef HRMErr_t ( *HRMOracleFn_t )( HRMVal_t const * const inbox, uint8_t const inbox_len, HRMVal_t * const outbox, uint8_t const outbox_cap,
+                                     uint8_t * const outbox_len );
+
+/*
+    Set either oracle_fn, or oracle_pgm and oracle_pgm_len. A trusted program is executed in the same room as the program under test.
+*/
+typedef struct HRMOracle_s
+{
+    HRMOracleFn_t oracle_fn;
+    HRMInstruction_t const * oracle_pgm;
+    uint8_t oracle_pgm_len;
+
+} HRMOracle_t;
+
+typedef struct HRMVerifyResult_s
+{
+    uint8_t passed;
+    uint32_t num_cases;
+    HRMErr_t failing_err;
+    HRMVal_t failing_inbox[VERIFY_MAX_INBOX_LEN];
+    uint8_t failing_inbox_len;
+    uint16_t worst_case_steps;
+    uint16_t average_steps;
+
+} HRMVerifyResult_t;
+
+typedef struct HRMVerifier_s
+{
+    HRMRoom_t const * room;
+    HRMInstruction_t const * pgm;
+    uint8_t pgm_len;
+    HRMOracle_t const * oracle;
+    uint32_t steps_total;
+    uint32_t num_scored;
+    HRMVerifyResult_t * result;
+
+} HRMVerifier_t;
+
+static HRMVal_t const adversarial_vals[] = { { NUM,  .val.n = HRM_NUM_MIN     },
+                                             { NUM,  .val.n = HRM_NUM_MIN + 1 },
+                                             { NUM,  .val.n = -1              },
+                                             { NUM,  .val.n =  0              },
+                                             { NUM,  .val.n =  1              },
+                                             { NUM,  .val.n = HRM_NUM_MAX - 1 },
+                                             { NUM,  .val.n = HRM_NUM_MAX     },
+                                             { CHAR, .val.c = 'A'             },
+                                             { CHAR, .val.c = 'Z'             } };
+
+#define NUM_ADVERSARIAL_VALS ( sizeof( adversarial_vals ) / sizeof( HRMVal_t ) )
+
+static HRMVal_t verify_mem[VERIFY_MAX_MEMORY_SIZE];
+static HRMVal_t verify_outbox[VERIFY_MAX_OUTBOX_LEN];
+static HRMVal_t verify_expected_outbox[VERIFY_MAX_OUTBOX_LEN];
+static HRMVal_t verify_inbox[VERIFY_MAX_INBOX_LEN];
+
+#define VERIFY_RNG_SEED ( 0xACE1u )
+
+static uint16_t verify_rng_state = VERIFY_RNG_SEED;
+
+
+/*
+    16-bit xorshift; cheap on an 8-bit target, and deterministic so that a failing run can be reproduced.
+*/
+static uint16_t verify_rand( void )
+{
+    verify_rng_state ^= ( uint16_t )( verify_rng_state << 7 );
+    verify_rng_state ^= ( uint16_t )( verify_rng_state >> 9 );
+    verify_rng_state ^= ( uint16_t )( verify_rng_state << 8 );
+
+    return verify_rng_state;
+
+}
+
+
+static uint16_t verify_num_domain_size( HRMRoom_t const * const room )
+{
+    return ( uint16_t )( room->allow_nums ? ( room->num_max - room->num_min + 1 ) : 0 );
+
+}
+
+
+static uint16_t verify_domain_size( HRMRoom_t const * const room )
+{
+    return ( uint16_t )( verify_num_domain_size( room ) + ( room->allow_chars ? HRM_CHAR_DOMAIN_SIZE : 0 ) );
+
+}
+
+
+/*
+    Map an index in 0..verify_domain_size() - 1 to an inbox value. Numbers come first, then characters.
+*/
+static HRMVal_t verify_domain_val( HRMRoom_t const * const room, uint16_t idx )
+{
+    uint16_t const num_domain_size = verify_num_domain_size( room );
+    HRMVal_t value;
+
+    if ( idx < num_domain_size )
+    {
+        value.type = NUM;
+        value.val.n = ( hrm_num )( room->num_min + ( int16_t )idx );
+    }
+    else
+    {
+        idx -= num_domain_size;
+        value.type = CHAR;
+        value.val.c = ( hrm_char )( 'A' + idx );
+    }
+
+    return value;
+
+}
+
+
+static uint8_t verify_val_allowed( HRMRoom_t const * const room, HRMVal_t const value )
+{
+    return ( uint8_t )( ( ( NUM == value.type ) && room->allow_nums && ( value.val.n >= room->num_min ) && ( value.val.n <= room->num_max ) ) ||
+                        ( ( CHAR == value.type ) && room->allow_chars ) );
+
+}
+
+
+static uint8_t verify_vals_equal( HRMVal_t const a, HRMVal_t const b )
+{
+    uint8_t equal = ( uint8_t )( a.type == b.type );
+
+    if ( equal && ( NUM == a.type ) )
+    {
+        equal = ( uint8_t )( a.val.n == b.val.n );
+    }
+    else if ( equal && ( CHAR == a.type ) )
+    {
+        equal = ( uint8_t )( a.val.c == b.val.c );
+    }
+
+    return equal;
+
+}
+
+
+static void verify_reset_mem( HRMRoom_t const * const room )
+{
+    uint8_t idx;
+
+    for ( idx = 0; idx < room->mem_len; idx++ )
+    {
+        verify_mem[idx] = room->mem_init[idx];
+    }
+
+}
+
+
+/*
+    Run one inbox through both the program under test and the oracle. Returns ERR_NONE if they agree, ERR_VERIFY_COUNTEREXAMPLE if they
+    disagree, or ERR_VERIFY_ORACLE_OUTBOX_TOO_SMALL if the oracle's answer doesn't fit in the verifier's outbox. *pgm_err holds the error the
+    program stopped with and *steps the number of instructions it executed.
+*/
+static HRMErr_t verify_case( HRMVerifier_t const * const v, HRMVal_t const * const inbox, uint8_t const inbox_len, HRMErr_t * const pgm_err,
+                             uint16_t * const steps )
+{
+    HRMRun_t run = { inbox, inbox_len, verify_outbox, VERIFY_MAX_OUTBOX_LEN, 0, 0 };
+    HRMRun_t expected = { inbox, inbox_len, verify_expected_outbox, VERIFY_MAX_OUTBOX_LEN, 0, 0 };
+    HRMErr_t expected_err = ERR_NONE;
+    HRMErr_t err = ERR_NONE;
+    uint8_t idx;
+
+    verify_reset_mem( v->room );
+    *pgm_err = execute( v->pgm, v->pgm_len, verify_mem, v->room->mem_len, &run );
+
+    if ( v->oracle->oracle_fn )
+    {
+        expected_err = v->oracle->oracle_fn( inbox, inbox_len, verify_expected_outbox, VERIFY_MAX_OUTBOX_LEN, &expected.outbox_len );
+    }
+    else
+    {
+        verify_reset_mem( v->room );
+        expected_err = execute( v->oracle->oracle_pgm, v->oracle->oracle_pgm_len, verify_mem, v->room->mem_len, &expected );
+    }
+
+    /* If the oracle overflows the outbox we don't know the right answer; that's a limit of the verifier, not a fault in the program */
+    if ( ERR_OUTBOX_FULL == expected_err )
+    {
+        err = ERR_VERIFY_ORACLE_OUTBOX_TOO_SMALL;
+    }
+    else if ( ( *pgm_err != expected_err ) || ( run.outbox_len != expected.outbox_len ) )
+    {
+        err = ERR_VERIFY_COUNTEREXAMPLE;
+    }
+
+    for ( idx = 0; ( ERR_NONE == err ) && ( idx < run.outbox_len ); idx++ )
+    {
+        if ( !verify_vals_equal( verify_outbox[idx], verify_expected_outbox[idx] ) )
+        {
+            err = ERR_VERIFY_COUNTEREXAMPLE;
+        }
+    }
+
+    *steps = run.steps;
+
+    return err;
+
+}
+
+
+/*
+    Shrink the failing inbox held in the result: drop values, then move numbers towards zero and characters towards 'A', keeping each change
+    only if the inbox still fails. Repeat until nothing changes.
+*/
+static void verify_shrink( HRMVerifier_t const * const v )
+{
+    HRMVerifyResult_t * const result = v->result;
+    HRMVal_t candidate[VERIFY_MAX_INBOX_LEN];
+    HRMVal_t simpler;
+    HRMErr_t err;
+    uint16_t steps;
+    uint8_t changed = 1;
+    uint8_t idx;
+    uint8_t src;
+    uint8_t dst;
+
+    while ( changed )
+    {
+        changed = 0;
+
+        for ( idx = 0; idx < result->failing_inbox_len; idx++ )
+        {
+            for ( src = 0, dst = 0; src < result->failing_inbox_len; src++ )
+            {
+                if ( src != idx )
+                {
+                    candidate[dst] = result->failing_inbox[src];
+                    dst += 1;
+                }
+            }
+            if ( ERR_VERIFY_COUNTEREXAMPLE == verify_case( v, candidate, dst, &err, &steps ) )
+            {
+                for ( src = 0; src < dst; src++ )
+                {
+                    result->failing_inbox[src] = candidate[src];
+                }
+                result->failing_inbox_len = dst;
+                result->failing_err = err;
+                changed = 1;
+                idx -= 1; /* The next value has moved into this slot; wraps to 0 when idx was 0 */
+            }
+        }
+
+        for ( idx = 0; idx < result->failing_inbox_len; idx++ )
+        {
+            simpler = result->failing_inbox[idx];
+            if ( ( NUM == simpler.type ) && ( 0 != simpler.val.n ) )
+            {
+                simpler.val.n /= 2;
+            }
+            else if ( ( CHAR == simpler.type ) && ( 'A' != simpler.val.c ) )
+            {
+                simpler.val.c -= 1;
+            }
+            else
+            {
+                continue;
+            }
+
+            if ( !verify_val_allowed( v->room, simpler ) )
+            {
+                continue; /* The room's number range doesn't reach any closer to zero */
+            }
+
+            for ( src = 0; src < result->failing_inbox_len; src++ )
+            {
+                candidate[src] = result->failing_inbox[src];
+            }
+            candidate[idx] = simpler;
+            if ( ERR_VERIFY_COUNTEREXAMPLE == verify_case( v, candidate, result->failing_inbox_len, &err, &steps ) )
+            {
+                result->failing_inbox[idx] = simpler;
+                result->failing_err = err;
+                changed = 1;
+            }
+        }
+    }
+
+}
+
+
+/*
+    Check one inbox, updating the step statistics. Returns the result of verify_case(); on ERR_VERIFY_COUNTEREXAMPLE the counterexample is
+    recorded and shrunk.
+*/
+static HRMErr_t verify_inbox_case( HRMVerifier_t * const v, uint8_t const inbox_len )
+{
+    HRMVerifyResult_t * const result = v->result;
+    HRMErr_t pgm_err;
+    uint16_t steps;
+    HRMErr_t err = verify_case( v, verify_inbox, inbox_len, &pgm_err, &steps );
+    uint8_t idx;
+
+    result->num_cases += 1;
+
+    if ( ERR_VERIFY_COUNTEREXAMPLE == err )
+    {
+        for ( idx = 0; idx < inbox_len; idx++ )
+        {
+            result->failing_inbox[idx] = verify_inbox[idx];
+        }
+        result->failing_inbox_len = inbox_len;
+        result->failing_err = pgm_err;
+        verify_shrink( v );
+    }
+    else if ( ( ERR_NONE == err ) && ( ERR_NONE == pgm_err ) )
+    {
+        if ( steps > result->worst_case_steps )
+        {
+            result->worst_case_steps = steps;
+        }
+        if ( inbox_len == v->room->max_inbox_len )
+        {
+            v->steps_total += steps;
+            v->num_scored += 1;
+        }
+    }
+
+    return err;
+
+}
+
+
+/*
+    Every inbox of exactly len values drawn from the adversarial values the room allows. The inbox is treated as an odometer over
+    adversarial_vals, skipping combinations containing values the room doesn't allow.
+*/
+static HRMErr_t verify_adversarial( HRMVerifier_t * const v, uint8_t const len )
+{
+    uint8_t digits[VERIFY_MAX_ADVERSARIAL_LEN] = { 0 };
+    HRMErr_t err = ERR_NONE;
+    uint8_t allowed;
+    uint8_t done = 0;
+    uint8_t idx;
+
+    while ( ( ERR_NONE == err ) && ( 0 == done ) )
+    {
+        allowed = 1;
+        for ( idx = 0; idx < len; idx++ )
+        {
+            verify_inbox[idx] = adversarial_vals[digits[idx]];
+            allowed &= verify_val_allowed( v->room, verify_inbox[idx] );
+        }
+        if ( allowed )
+        {
+            err = verify_inbox_case( v, len );
+        }
+
+        for ( idx = 0; idx < len; idx++ )
+        {
+            digits[idx] += 1;
+            if ( digits[idx] < NUM_ADVERSARIAL_VALS )
+            {
+                break;
+            }
+            digits[idx] = 0;
+        }
+        done = ( uint8_t )( idx == len );
+    }
+
+    return err;
+
+}
+
+
+/*
+    Pick a random inbox value. One value in four is drawn from the boundary values, so that zeros, extremes and letters turn up in random
+    inboxes far more often than a uniform draw over the domain would produce them.
+*/
+static HRMVal_t verify_random_val( HRMRoom_t const * const room, uint16_t const domain_size )
+{
+    uint16_t const r = verify_rand();
+    HRMVal_t value = adversarial_vals[( r >> 2 ) % NUM_ADVERSARIAL_VALS];
+
+    if ( ( 0 != ( r & 3 ) ) || !verify_val_allowed( room, value ) )
+    {
+        value = verify_domain_val( room, ( uint16_t )( verify_rand() % domain_size ) );
+    }
+
+    return value;
+
+}
+
+
+/*
+    Returns ERR_NONE once verification has run (check result->passed), or an error if the room or the oracle's answers don't fit in the
+    verifier's buffers.
+*/
+static HRMErr_t verify( HRMVerifier_t * const v )
+{
+    HRMRoom_t const * const room = v->room;
+    HRMVerifyResult_t * const result = v->result;
+    uint16_t const domain_size = verify_domain_size( room );
+    uint8_t const max_len = room->max_inbox_len;
+    HRMErr_t err = ERR_NONE;
+    uint8_t len;
+    uint8_t idx;
+    uint16_t case_idx;
+
+    result->num_cases = 0;
+    result->failing_err = ERR_NONE;
+    result->failing_inbox_len = 0;
+    result->worst_case_steps = 0;
+    result->average_steps = 0;
+    result->passed = 0;
+    verify_rng_state = VERIFY_RNG_SEED; /* Every verification sees the same random inboxes */
+    v->steps_total = 0;
+    v->num_scored = 0;
+
+    if ( room->mem_len > VERIFY_MAX_MEMORY_SIZE )
+    {
+        err = ERR_VERIFY_ROOM_MEMORY_TOO_LARGE;
+    }
+    else if ( room->max_inbox_len > VERIFY_MAX_INBOX_LEN )
+    {
+        err = ERR_VERIFY_ROOM_INBOX_TOO_LARGE;
+    }
+    else if ( room->allow_nums && ( ( room->num_min > room->num_max ) || ( room->num_min < HRM_NUM_MIN ) || ( room->num_max > HRM_NUM_MAX ) ) )
+    {
+        err = ERR_VERIFY_ROOM_BAD_NUM_RANGE;
+    }
+
+    /* The empty inbox */
+    if ( ERR_NONE == err )
+    {
+        err = verify_inbox_case( v, 0 );
+    }
+
+    /* Every single-value inbox */
+    for ( case_idx = 0; ( ERR_NONE == err ) && ( max_len >= 1 ) && ( case_idx < domain_size ); case_idx++ )
+    {
+        verify_inbox[0] = verify_domain_val( room, case_idx );
+        err = verify_inbox_case( v, 1 );
+    }
+
+    /* Short inboxes of boundary values */
+    for ( len = 2; ( ERR_NONE == err ) && ( len <= max_len ) && ( len <= VERIFY_MAX_ADVERSARIAL_LEN ); len++ )
+    {
+        err = verify_adversarial( v, len );
+    }
+
+    /* Random inboxes; every other one is full size, so the average step count is taken over plenty of them */
+    for ( case_idx = 0; ( ERR_NONE == err ) && ( max_len >= 1 ) && ( domain_size > 0 ) &&
+                        ( case_idx < VERIFY_NUM_RANDOM_INBOXES ); case_idx++ )
+    {
+        len = ( uint8_t )( ( case_idx & 1 ) ? max_len : ( 1 + ( ( case_idx >> 1 ) % max_len ) ) );
+        for ( idx = 0; idx < len; idx++ )
+        {
+            verify_inbox[idx] = verify_random_val( room, domain_size );
+        }
+        err = verify_inbox_case( v, len );
+    }
+
+    result->passed = ( uint8_t )( ERR_NONE == err );
+    if ( ERR_VERIFY_COUNTEREXAMPLE == err )
+    {
+        err = ERR_NONE; /* A counterexample is the verdict on the program, not a failure to verify it */
+    }
+    if ( v->num_scored > 0 )
+    {
+        result->average_steps = ( uint16_t )( v->steps_total / v->num_scored );
+    }
+
+    return err;
+
+}
+
+
+/*
+    Reference oracle for the Zero Preservation Initiative: send only the zeros to the outbox.
+*/
+static HRMErr_t oracle_zero_preservation_initiative( HRMVal_t const * const inbox, uint8_t const inbox_len, HRMVal_t * const outbox,
+                                                     uint8_t const outbox_cap, uint8_t * const outbox_len )
+{
+    HRMErr_t err = ERR_NONE;
+    uint8_t idx;
+
+    *outbox_len = 0;
+
+    for ( idx = 0; ( ERR_NONE == err ) && ( idx < inbox_len ); idx++ )
+    {
+        if ( ( NUM == inbox[idx].type ) && ( 0 == inbox[idx].val.n ) )
+        {
+            if ( *outbox_len >= outbox_cap )
+            {
+                err = ERR_OUTBOX_FULL;
+            }
+            else
+            {
+                outbox[*outbox_len] = inbox[idx];
+                *outbox_len += 1;
+            }
+        }
+    }
+
+    return err;
+
+}
+
+/*
+    The sample inbox from the game holds 8 values; verify with the largest inbox the verifier supports.
+*/
+static HRMRoom_t const room_zero_preservation_initiative = { mem_zero_preservation_initiative, ROOM_MEMORY_SIZE_ZERO_PRESERVATION_INITIATIVE,
+                                                             VERIFY_MAX_INBOX_LEN, 1, HRM_NUM_MIN, HRM_NUM_MAX, 1 };
+
+/*
+    Reference oracle for the Tripler Room: send each number multiplied by three. The program adds the number to itself twice, so an
+    out-of-range result stops it at whichever of the two sums first leaves -999..999.
+*/
+static HRMErr_t oracle_tripler_room( HRMVal_t const * const inbox, uint8_t const inbox_len, HRMVal_t * const outbox, uint8_t const outbox_cap,
+                                     uint8_t * const outbox_len )
+{
+    HRMErr_t err = ERR_NONE;
+    int16_t sum;
+    uint8_t step;
+    uint8_t idx;
+
+    *outbox_len = 0;
+
+    for ( idx = 0; ( ERR_NONE == err ) && ( idx < inbox_len ); idx++ )
+    {
+        for ( step = 2; ( ERR_NONE == err ) && ( step <= 3 ); step++ )
+        {
+            sum = ( int16_t )( inbox[idx].val.n * step );
+            if ( sum < HRM_NUM_MIN )
+            {
+                err = ERR_UNDERFLOW;
+            }
+            else if ( sum > HRM_NUM_MAX )
+            {
+                err = ERR_OVERFLOW;
+            }
+        }
+
+        if ( ERR_NONE != err )
+        {
+            /* Stopped with an error */
+        }
+        else if ( *outbox_len >= outbox_cap )
+        {
+            err = ERR_OUTBOX_FULL;
+        }
+        else
+        {
+            outbox[*outbox_len].type = NUM;
+            outbox[*outbox_len].val.n = ( hrm_num )sum;
+            *outbox_len += 1;
+        }
+    }
+
+    return err;
+
+}
+
+/*
+    The game only feeds the Tripler Room small numbers. Within -333..333 every number can be tripled, so each inbox runs to completion.
+*/
+static HRMRoom_t const room_tripler_room = { mem_tripler_room, ROOM_MEMORY_SIZE_TRIPLER_ROOM, VERIFY_MAX_INBOX_LEN, 1, -333, 333, 0 };
+
+static HRMOracle_t const oracle_zpi = { oracle_zero_preservation_initiative, 0, 0 };
+static HRMOracle_t const oracle_zpi_pgm = { 0, pgm_zero_preservation_initiative, PGM_LEN( pgm_zero_preservation_initiative ) };
+static HRMOracle_t const oracle_tripler = { oracle_tripler_room, 0, 0 };
+
+/* Shared by every verification in main(); each one overwrites the last */
+static HRMVerifyResult_t verify_result;
+
+
+/*
+    Verify a program and check that the verifier came to the expected conclusion. A passing program must report sane step counts; a failing
+    one must have been caught.
+*/
+static HRMErr_t verify_expect( HRMRoom_t const * const room, HRMInstruction_t const * const pgm, uint8_t const pgm_len,
+                               HRMOracle_t const * const oracle, HRMVerifyResult_t * const result, uint8_t const expect_pass )
+{
+    HRMVerifier_t verifier = { room, pgm, pgm_len, oracle, 0, 0, result };
+    HRMErr_t err = verify( &verifier );
+
+    if ( ERR_NONE != err )
+    {
+        /* The room was rejected */
+    }
+    else if ( expect_pass && !result->passed )
+    {
+        err = ERR_VERIFY_COUNTEREXAMPLE;
+    }
+    else if ( !expect_pass && result->passed )
+    {
+        err = ERR_VERIFY_MISSED_COUNTEREXAMPLE;
+    }
+    else if ( expect_pass && ( ( 0 == result->average_steps ) || ( result->average_steps > result->worst_case_steps ) ) )
+    {
+        err = ERR_VERIFY_BAD_STEP_COUNTS;
+    }
+
     return err;
 
 }
 
 int main(void)
 {
-    uint8_t err = execute( pgm_zero_preservation_initiative, ( uint8_t )( sizeof( pgm_zero_preservation_initiative ) / sizeof( HRMInstruction_t ) ),
-                           mem_zero_preservation_initiative, ( uint8_t )ROOM_MEMORY_SIZE_ZERO_PRESERVATION_INITIATIVE );
+    HRMRun_t run = { in_fifo, NUM_INBOX_VALUES, out_fifo, NUM_INBOX_VALUES, 0, 0 };
+    HRMErr_t err;
+    uint16_t zpi_worst_case_steps;
+    uint8_t idx;
+
+    /* Run the sample on a copy of the room floor, so the room's initial floor is still intact for the verifier */
+    for ( idx = 0; idx < ROOM_MEMORY_SIZE_ZERO_PRESERVATION_INITIATIVE; idx++ )
+    {
+        floor_a[idx] = mem_zero_preservation_initiative[idx];
+    }
+
+    err = execute( pgm_zero_preservation_initiative, PGM_LEN( pgm_zero_preservation_initiative ),
+                   floor_a, ( uint8_t )ROOM_MEMORY_SIZE_ZERO_PRESERVATION_INITIATIVE, &run );
+
+    /* The solution against a C oracle */
+    if ( ERR_NONE == err )
+    {
+        err = verify_expect( &room_zero_preservation_initiative, pgm_zero_preservation_initiative, PGM_LEN( pgm_zero_preservation_initiative ),
+                             &oracle_zpi, &verify_result, 1 );
+        zpi_worst_case_steps = verify_result.worst_case_steps;
+    }
+
+    /* A solution using the floor against the first solution as a trusted program; it takes two more steps per value */
+    if ( ERR_NONE == err )
+    {
+        err = verify_expect( &room_zero_preservation_initiative, pgm_zero_preservation_initiative_via_floor,
+                             PGM_LEN( pgm_zero_preservation_initiative_via_floor ), &oracle_zpi_pgm, &verify_result, 1 );
+    }
+
+    if ( ( ERR_NONE == err ) && ( verify_result.worst_case_steps <= zpi_worst_case_steps ) )
+    {
+        err = ERR_VERIFY_BAD_STEP_COUNTS;
+    }
+
+    /* Arithmetic against a C oracle */
+    if ( ERR_NONE == err )
+    {
+        err = verify_expect( &room_tripler_room, pgm_tripler_room, PGM_LEN( pgm_tripler_room ), &oracle_tripler, &verify_result, 1 );
+    }
+
+    /* A wrong solution must be caught, and shrunk to the smallest failing inbox: a single -1 */
+    if ( ERR_NONE == err )
+    {
+        err = verify_expect( &room_zero_preservation_initiative, pgm_zero_preservation_initiative_broken,
+                             PGM_LEN( pgm_zero_preservation_initiative_broken ), &oracle_zpi, &verify_result, 0 );
+    }
+
+    if ( ( ERR_NONE == err ) &&
+         ( ( 1 != verify_result.failing_inbox_len ) ||
+           ( NUM != verify_result.failing_inbox[0].type ) ||
+           ( -1 != verify_result.failing_inbox[0].val.n ) ) )
+    {
+        err = ERR_VERIFY_COUNTEREXAMPLE_NOT_SHRUNK;
+    }
 
     return ( int )err;
 